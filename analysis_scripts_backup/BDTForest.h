@@ -0,0 +1,238 @@
+#ifndef BDTFOREST_H
+#define BDTFOREST_H
+
+//   Flat, batch evaluator for TMVA BDT forests (AdaBoost and Grad).
+//
+//   The dataset/weights/TMVAClassification_<method>.weights.xml forest is read into
+//   one contiguous node array (variable index, cut, two children, leaf value).
+//   Leaves point to themselves, so every event of a batch walks the same number of
+//   levels per tree without branches, and the inner loop runs over events:
+//
+//     idx[e] = child[2*idx[e] + (x[var[idx[e]]][e] >= cut[idx[e]])]
+//
+//   Inputs are structure-of-arrays floats (column v of a batch at x + v*stride),
+//   exactly as the Float_t variables handed to TMVA::Reader. The per-event sum runs
+//   over the trees in the same order and with the same types as MethodBDT, so the
+//   result should be bit-identical to Reader::EvaluateMVA; TMVABatchApplication.C
+//   checks this event by event with its nCheck argument. Grad forests are written as
+//   regression trees (AnalysisType 1), whose leaves hold the response "res".
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TString.h"
+#include "TXMLEngine.h"
+
+// a*b+c must not be contracted to an FMA, MethodBDT rounds the product first
+#if defined(__clang__)
+#define BDTFOREST_NOCONTRACT
+#elif defined(__GNUC__)
+#define BDTFOREST_NOCONTRACT __attribute__((optimize("fp-contract=off")))
+#else
+#define BDTFOREST_NOCONTRACT
+#endif
+
+class BDTForest {
+
+public:
+
+   BDTForest() : fGrad(false), fRegression(false), fUseYesNoLeaf(true), fNVar(0) {}
+
+   // Returns false (and prints why) if the weight file uses a feature this
+   // evaluator does not reproduce; use TMVA::Reader for such methods.
+   bool Load(const char* weightfile)
+   {
+      fRoot.clear(); fDepth.clear(); fBoostWeight.clear();
+      fVar.clear(); fCut.clear(); fChild.clear(); fLeaf.clear(); fVarExpr.clear();
+
+      TXMLEngine xml;
+      XMLDocPointer_t doc = xml.ParseFile(weightfile);
+      if (!doc) { std::cout << "BDTForest: cannot parse " << weightfile << std::endl; return false; }
+      XMLNodePointer_t top = xml.DocGetRootElement(doc);
+
+      TString boostType = "AdaBoost";
+      fGrad = false;
+      fRegression = false;
+      fUseYesNoLeaf = true;
+      bool ok = true;
+
+      for (XMLNodePointer_t n = xml.GetChild(top); n && ok; n = xml.GetNext(n)) {
+         TString name = xml.GetNodeName(n);
+
+         if (name == "Options") {
+            for (XMLNodePointer_t o = xml.GetChild(n); o; o = xml.GetNext(o)) {
+               TString oname = xml.GetAttr(o, "name");
+               TString oval  = xml.GetNodeContent(o);
+               if (oname == "BoostType")      { boostType = oval; fGrad = (oval == "Grad"); }
+               if (oname == "UseYesNoLeaf")   fUseYesNoLeaf = (oval == "True" || oval == "1");
+               if (oname == "DoPreselection" && (oval == "True" || oval == "1")) {
+                  std::cout << "BDTForest: DoPreselection is not supported" << std::endl;
+                  ok = false;
+               }
+            }
+         }
+         else if (name == "Variables") {
+            for (XMLNodePointer_t v = xml.GetChild(n); v; v = xml.GetNext(v))
+               fVarExpr.push_back(xml.GetAttr(v, "Expression"));
+            fNVar = fVarExpr.size();
+         }
+         else if (name == "Transformations") {
+            if (Read<int>(xml, n, "NTransformations") != 0) {
+               std::cout << "BDTForest: input variable transformations are not supported" << std::endl;
+               ok = false;
+            }
+         }
+         else if (name == "Weights") {
+            // Types::kClassification, or kRegression for the trees of BoostType=Grad
+            const int analysisType = Read<int>(xml, n, "AnalysisType");
+            if (analysisType != 0 && analysisType != 1) {
+               std::cout << "BDTForest: only classification and regression trees are supported" << std::endl;
+               ok = false;
+            }
+            fRegression = (analysisType == 1);
+            for (XMLNodePointer_t t = xml.GetChild(n); t && ok; t = xml.GetNext(t)) {
+               fBoostWeight.push_back(Read<Double_t>(xml, t, "boostWeight"));
+               fRoot.push_back(fVar.size());
+               int depth = 0;
+               ok = AddNode(xml, xml.GetChild(t), 0, depth);
+               fDepth.push_back(depth);
+            }
+         }
+      }
+      xml.FreeDoc(doc);
+
+      if (ok && fRoot.empty()) {
+         std::cout << "BDTForest: no trees found in " << weightfile << std::endl;
+         ok = false;
+      }
+      if (ok) {
+         // point leaves to themselves, see AddNode
+         for (size_t k = 0; k < fVar.size(); ++k) {
+            if (fChild[2*k] < 0) { fChild[2*k] = k; fChild[2*k+1] = k; fVar[k] = 0; }
+         }
+         std::cout << "BDTForest: " << weightfile << " : " << fRoot.size() << " trees ("
+                   << boostType << "), " << fVar.size() << " nodes, " << fNVar << " variables" << std::endl;
+      }
+      return ok;
+   }
+
+   UInt_t GetNVar() const { return fNVar; }
+   const TString& GetVarExpression(UInt_t i) const { return fVarExpr[i]; }
+
+   // n events, variable v of event e at x[v*stride + e]
+   BDTFOREST_NOCONTRACT
+   void Evaluate(const float* x, size_t stride, size_t n, double* out) const
+   {
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#endif
+      std::vector<int>    idx(n);
+      std::vector<double> sum(n, 0.);
+      double norm = 0.;
+
+      const int*   var   = fVar.data();
+      const float* cut   = fCut.data();
+      const int*   child = fChild.data();
+      const double* leaf = fLeaf.data();
+
+      for (size_t t = 0; t < fRoot.size(); ++t) {
+         const int root = fRoot[t];
+         for (size_t e = 0; e < n; ++e) idx[e] = root;
+         for (int d = 0; d < fDepth[t]; ++d) {
+            for (size_t e = 0; e < n; ++e) {
+               const int k = idx[e];
+               idx[e] = child[2*k + (x[var[k]*stride + e] >= cut[k])];
+            }
+         }
+         if (fGrad) {
+            for (size_t e = 0; e < n; ++e) sum[e] += leaf[idx[e]];
+         } else {
+            const double w = fBoostWeight[t];
+            for (size_t e = 0; e < n; ++e) sum[e] += w * leaf[idx[e]];
+            norm += w;
+         }
+      }
+
+      for (size_t e = 0; e < n; ++e) {
+         if (fGrad) out[e] = 2.0/(1.0+exp(-2.0*sum[e]))-1;
+         else       out[e] = (norm > std::numeric_limits<double>::epsilon()) ? sum[e]/norm : 0;
+      }
+   }
+
+private:
+
+   template <typename T>
+   static T Read(TXMLEngine& xml, XMLNodePointer_t n, const char* attr)
+   {
+      // same conversion as TMVA::Tools::ReadAttr
+      T value = T();
+      const char* s = xml.GetAttr(n, attr);
+      if (s) { std::stringstream ss(s); ss >> value; }
+      return value;
+   }
+
+   // Appends the subtree at n; leaves get child = -1 and are fixed up in Load().
+   bool AddNode(TXMLEngine& xml, XMLNodePointer_t n, int depth, int& maxDepth)
+   {
+      if (!n) return false;
+      if (Read<int>(xml, n, "NCoef") > 0) {
+         std::cout << "BDTForest: Fisher cuts are not supported" << std::endl;
+         return false;
+      }
+      if (depth > maxDepth) maxDepth = depth;
+
+      const int k = fVar.size();
+      const int ivar = Read<int>(xml, n, "IVar");
+      const bool cType = Read<int>(xml, n, "cType") != 0;
+      fVar.push_back(ivar);
+      fCut.push_back(Read<Float_t>(xml, n, "Cut"));
+      fChild.push_back(-1);
+      fChild.push_back(-1);
+
+      // leaf value as returned by DecisionTree::CheckEvent
+      const int nType = Read<int>(xml, n, "nType");
+      if (fRegression)               fLeaf.push_back(Read<Float_t>(xml, n, "res"));
+      else if (fUseYesNoLeaf)        fLeaf.push_back(Double_t(nType));
+      else                           fLeaf.push_back(Read<Float_t>(xml, n, "purity"));
+
+      if (nType != 0) return true;
+
+      int l = -1, r = -1;
+      for (XMLNodePointer_t c = xml.GetChild(n); c; c = xml.GetNext(c)) {
+         TString pos = xml.GetAttr(c, "pos");
+         const int kc = fVar.size();
+         if (!AddNode(xml, c, depth+1, maxDepth)) return false;
+         if (pos == "l") l = kc;
+         else            r = kc;
+      }
+      if (l < 0 || r < 0) {
+         std::cout << "BDTForest: intermediate node without two daughters" << std::endl;
+         return false;
+      }
+      // DecisionTreeNode::GoesRight: (x >= cut) if cType, !(x >= cut) otherwise
+      fChild[2*k]   = cType ? l : r;
+      fChild[2*k+1] = cType ? r : l;
+      return true;
+   }
+
+   bool fGrad;
+   bool fRegression;
+   bool fUseYesNoLeaf;
+   UInt_t fNVar;
+   std::vector<TString> fVarExpr;
+
+   std::vector<int>    fRoot;
+   std::vector<int>    fDepth;
+   std::vector<double> fBoostWeight;
+
+   std::vector<int>    fVar;
+   std::vector<float>  fCut;
+   std::vector<int>    fChild;
+   std::vector<double> fLeaf;
+};
+
+#endif
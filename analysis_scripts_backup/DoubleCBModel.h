@@ -0,0 +1,133 @@
+#ifndef DOUBLECBMODEL_H
+#define DOUBLECBMODEL_H
+
+//   The double Crystal Ball signal model of cbshapef2p.C and its fit.
+//
+//   DoubleCBModel owns the observable, the parameters (same names, start values
+//   and ranges as cbshapef2p.C) and the extended pdf, so the nominal fit and every
+//   toy build exactly the same model.
+//
+//   FitDoubleCB() is the extended maximum-likelihood fit with
+//     - a binned fit in Bmass.getBins() bins when the sample has more than
+//       maxUnbinned entries; the bins are much narrower than the resolution,
+//     - the likelihood split over nCPU processes if nCPU > 1. nCPU = 0 (the
+//       default) splits it over all cores when the fitted data has more than
+//       kCBMinParallel entries or bins and keeps one process below that, where
+//       the workers cost more than they save,
+//     - vectorized likelihood evaluation in one process.
+//   ROOT >= 6.30 splits the likelihood with RooFit::Parallelize and the modular
+//   likelihood when it is built with roofit_multiprocess and with NumCPU on the
+//   legacy backend otherwise; the vectorized backend cannot be split there.
+//   Older ROOT splits the vectorized (BatchMode) likelihood with NumCPU. The
+//   backend used is printed.
+
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "RVersion.h"
+#include "RooAbsData.h"
+#include "RooAddPdf.h"
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooCBShape.h"
+#include "RooCmdArg.h"
+#include "RooDataHist.h"
+#include "RooDataSet.h"
+#include "RooExtendPdf.h"
+#include "RooFitResult.h"
+#include "RooGlobalFunc.h"
+#include "RooLinkedList.h"
+#include "RooRealVar.h"
+#include "TROOT.h"
+#include "TString.h"
+
+const Long64_t kCBMaxUnbinned = 1000000;
+const Long64_t kCBMinParallel = 200000;
+
+class DoubleCBModel {
+
+public:
+
+   DoubleCBModel(double bm_min = 5.27, double bm_max = 5.6, double nsigMax = 1E6)
+      : Bmass("Bmass", "#bf{m(K^{+}K^{-}#mu^{+}#mu^{-}) [GeV]}", bm_min, bm_max),
+        mean("mean", "common means for Crystal Balls", 5.367, bm_min, bm_max),
+        sigma1("sigma1", "sigma of CB1", 0.024, 0.002, 0.031),
+        sigma2("sigma2", "sigma of CB2", 0.045, 0.001, 0.1),
+        sigM_frac("sigM_frac", "fraction of CB", 0.44, 0., 1.),
+        n1("n1", "", 0.5),
+        n2("n2", "", 10.),
+        alpha1("alpha1", "alpha for CB1", 1., 1., 2.),
+        alpha2("alpha2", "alpha for CB2", -1., -2.0, -1.),
+        nsig("nsig", "nsig", 1E3, 500, nsigMax),
+        CB1("CB1", "Crystal Ball-1", Bmass, mean, sigma1, alpha1, n1),
+        CB2("CB2", "Crystal Ball-2", Bmass, mean, sigma2, alpha2, n2),
+        CB("CB", "CB1+CB2", RooArgList(CB1, CB2), RooArgList(sigM_frac)),
+        model("model", "model", CB, nsig)
+   {
+      Bmass.setBins(400);   // binning of the fallback fit, as in the plots
+   }
+
+   // the floating parameters, in the order of the toy outputs
+   RooArgList Parameters()
+   {
+      return RooArgList(nsig, mean, sigma1, sigma2, alpha1, alpha2, sigM_frac);
+   }
+
+   RooRealVar   Bmass;
+   RooRealVar   mean, sigma1, sigma2, sigM_frac, n1, n2, alpha1, alpha2, nsig;
+   RooCBShape   CB1, CB2;
+   RooAddPdf    CB;
+   RooExtendPdf model;
+};
+
+// nCPU: processes for the likelihood, 0 = all cores above kCBMinParallel entries, one below
+inline RooFitResult* FitDoubleCB(DoubleCBModel& m, RooAbsData& data, int nCPU = 0, bool minos = true,
+                                 int printLevel = 1, Long64_t maxUnbinned = kCBMaxUnbinned)
+{
+   RooAbsData* fitData = &data;
+   std::unique_ptr<RooDataHist> binned;
+   if (!dynamic_cast<RooDataHist*>(&data) && data.numEntries() > maxUnbinned) {
+      binned.reset(new RooDataHist("binned", "binned Bmass", RooArgSet(m.Bmass), data));
+      fitData = binned.get();
+      if (printLevel >= 0) std::cout << "FitDoubleCB: " << data.numEntries() << " entries, binned fit in "
+                                     << m.Bmass.getBins() << " bins" << std::endl;
+   }
+
+   if (nCPU <= 0) nCPU = (fitData->numEntries() > kCBMinParallel) ? (int)std::thread::hardware_concurrency() : 1;
+
+   std::vector<RooCmdArg> args = { RooFit::Extended(true), RooFit::Save(true), RooFit::Minos(minos),
+                                   RooFit::PrintLevel(printLevel) };
+   const char* backend = "vectorized";
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,30,0)
+   if (nCPU > 1) {
+      args.push_back(RooFit::EvalBackend::Legacy());
+      if (TString(gROOT->GetConfigFeatures()).Contains("roofit_multiprocess")) {
+         args.push_back(RooFit::Parallelize(nCPU));
+         args.push_back(RooFit::ModularL(true));
+         backend = "modular";
+      } else {
+         args.push_back(RooFit::NumCPU(nCPU));
+         backend = "legacy";
+      }
+   } else {
+      args.push_back(RooFit::EvalBackend::Cpu());
+   }
+#else
+   args.push_back(RooFit::BatchMode(true));
+   if (nCPU > 1) args.push_back(RooFit::NumCPU(nCPU));
+#endif
+   if (printLevel >= 0) {
+      std::cout << "FitDoubleCB: " << backend << " likelihood";
+      if (nCPU > 1) std::cout << " split over " << nCPU << " processes";
+      std::cout << std::endl;
+   }
+   if (printLevel < 0) args.push_back(RooFit::Verbose(false));
+
+   RooLinkedList cmds;
+   for (auto& a : args) cmds.Add(&a);
+   return m.model.fitTo(*fitData, cmds);
+}
+
+#endif
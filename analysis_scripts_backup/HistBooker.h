@@ -0,0 +1,74 @@
+#ifndef HISTBOOKER_H
+#define HISTBOOKER_H
+
+//   Lazy histogram booking on top of RDataFrame.
+//
+//   All (expression, binning, selection) triples of a chain are declared with Book()
+//   first; RunAll() then fills every booked histogram of every chain in one event loop
+//   per chain, run concurrently. With ROOT::EnableImplicitMT() each loop is split over
+//   the cores, with per-thread histograms merged at the end. Events passing the same
+//   selection string share one Filter node, so each selection is evaluated once per event.
+//
+//     HistBooker mc(*tr1), data(*tr2);
+//     for (...) { mc.Book(..., cutm); data.Book(..., cutd); }
+//     HistBooker::RunAll({&mc, &data});
+//     TH1D* h = mc.Get(i);   // caller owns h
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "TH1D.h"
+#include "TString.h"
+#include "TTree.h"
+#include "ROOT/RDataFrame.hxx"
+
+class HistBooker {
+
+public:
+
+   HistBooker(TTree& tree) : fDf(tree) {}
+
+   // Returns the index to pass to Get(). Nothing is read until RunAll().
+   size_t Book(const char* name, const char* expr, int nbins, double xmin, double xmax, const char* selection = "")
+   {
+      TString sel = TString(selection).Strip(TString::kBoth);
+      auto it = fFilters.find(sel.Data());
+      if (it == fFilters.end()) {
+         ROOT::RDF::RNode node = fDf;
+         if (sel.Length()) node = fDf.Filter(sel.Data());
+         it = fFilters.emplace(sel.Data(), node).first;
+      }
+
+      const std::string col = Form("hb_expr_%zu", fResults.size());
+      TString e = TString(expr).Strip(TString::kBoth);
+      auto h = it->second.Define(col, e.Data())
+                         .Histo1D(ROOT::RDF::TH1DModel(name, name, nbins, xmin, xmax), col);
+      fResults.push_back(h);
+      return fResults.size() - 1;
+   }
+
+   static void RunAll(const std::vector<HistBooker*>& bookers)
+   {
+      std::vector<ROOT::RDF::RResultHandle> handles;
+      for (auto b : bookers) handles.insert(handles.end(), b->fResults.begin(), b->fResults.end());
+      ROOT::RDF::RunGraphs(handles);
+   }
+
+   void Run() { RunAll({this}); }
+
+   TH1D* Get(size_t i)
+   {
+      TH1D* h = (TH1D*)fResults[i]->Clone();
+      h->SetDirectory(0);
+      return h;
+   }
+
+private:
+
+   ROOT::RDataFrame fDf;
+   std::map<std::string, ROOT::RDF::RNode> fFilters;
+   std::vector<ROOT::RDF::RResultPtr<TH1D>> fResults;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef NTUPLESCHEMA_H
+#define NTUPLESCHEMA_H
+
+//   Branches of the "tree" ntuples (*_cutopt.root), as read and copied by
+//   TMVAClassificationApplication.C: the Double_t branches Mumumass ... dr1 and the
+//   Int_t track quality and trigger flags. Shared by TMVABatchApplication.C and the
+//   synthetic ntuple generator make_synthetic_ntuples.C. kBDTInputBranches are the
+//   branches the BDT inputs and spectators are computed from, the only ones read by
+//   the score friend mode of both application macros. kSyntheticMarker is written by
+//   make_synthetic_ntuples.C next to its ntuples; benchmark_chain.C only works in a
+//   directory that has it.
+
+#include <string>
+#include <vector>
+
+const std::vector<std::string> kDoubleBranches = {
+   "Mumumass", "Mumumasserr", "Phimass", "Kmpt", "Kppt", "Kmeta", "Kpeta", "Kmphi", "Kpphi",
+   "Kmtrkdcasigbs", "Kptrkdcasigbs", "Mumpt", "Muppt", "Mumeta", "Mupeta", "Mumphi", "Mupphi",
+   "Mumdcasigbs", "Mupdcasigbs", "Bsdcasigbs", "MumMinIP", "MupMinIP", "MumMinIPE", "MupMinIPE",
+   "KptrkMinIP", "KptrkMinIPE", "KmtrkMinIP", "KmtrkMinIPE", "MumMinIP2D", "MupMinIP2D",
+   "MumMinIP2DE", "MupMinIP2DE", "mupIso", "mumIso", "BsIso", "kptrkIso", "kmtrkIso", "Bmass",
+   "Bpt", "Beta", "Bphi", "Phipt", "Phieta", "Phiphi", "Bvtxcl", "Blxysig", "Bcosalphabs",
+   "Bcosalphabs2d", "Q2", "dimupt", "dimueta", "dimuvtxcl", "dimulsig", "dimuDCA", "CosThetaL",
+   "CosThetaK", "Phi", "dr0", "dr1" };
+const std::vector<std::string> kIntBranches = {
+   "ptrkqual", "mtrkqual", "JpsiTriggers", "PsiPTriggers", "LMNTTriggers" };
+const std::vector<std::string> kBDTInputBranches = {
+   "Kmpt", "Kppt", "KmtrkMinIP", "KmtrkMinIPE", "KptrkMinIP", "KptrkMinIPE", "MumMinIP", "MumMinIPE",
+   "MupMinIP", "MupMinIPE", "Blxysig", "Bvtxcl", "Bcosalphabs2d", "Bsdcasigbs", "kmtrkIso", "kptrkIso",
+   "Bmass", "Mumumass" };
+
+const char* const kSyntheticMarker = ".synthetic_ntuples";
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef ROOTFILEID_H
+#define ROOTFILEID_H
+
+//   Identity of a ROOT file for cache checks: its UUID and end-of-file offset, so
+//   the id changes whenever the file is rewritten (RECREATE gives a new UUID, an
+//   update moves the end). "" if the file cannot be opened. Used by
+//   SelectionIndex.h and TMVAGridSearch.C.
+
+#include "TFile.h"
+#include "TString.h"
+#include "TUUID.h"
+
+inline TString RootFileId(const char* file)
+{
+   TFile* f = TFile::Open(file);
+   TString id = (f && !f->IsZombie()) ? Form("%s %lld", f->GetUUID().AsString(), f->GetEND()) : "";
+   delete f;
+   return id;
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef ROOTPROCESS_H
+#define ROOTPROCESS_H
+
+//   Running macros in separate root processes (Linux), for benchmark_chain.C and
+//   pipeline.C.
+//
+//   StartRoot() forks "root -l -b -q <args>" without waiting; args are passed to
+//   root as they are (macro calls, "-e" expressions), no shell is involved. The
+//   caller reaps the child with wait4()/waitpid(). CompileMacroOnce() builds the
+//   ACLiC library of a macro up front, so that processes started later, possibly
+//   concurrently, only load it. GlobFiles() lists the products of a stage given
+//   as wildcard patterns.
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "TRegexp.h"
+#include "TString.h"
+#include "TSystem.h"
+
+// logfile: stdout and stderr of the child (inherited if 0); returns -1 if fork failed
+inline pid_t StartRoot(const std::vector<std::string>& args, const char* logfile = 0)
+{
+   std::vector<std::string> cmd = { "root", "-l", "-b", "-q" };
+   cmd.insert(cmd.end(), args.begin(), args.end());
+   std::vector<char*> argv;
+   for (auto& a : cmd) argv.push_back(&a[0]);
+   argv.push_back(0);
+
+   std::cout.flush();
+   fflush(stdout);
+   fflush(stderr);
+
+   const pid_t pid = fork();
+   if (pid == 0) {
+      if (logfile) {
+         const int fd = open(logfile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+         if (fd >= 0) { dup2(fd, 1); dup2(fd, 2); close(fd); }
+      }
+      execvp("root", argv.data());
+      _exit(127);
+   }
+   return pid;
+}
+
+inline bool CompileMacroOnce(const TString& macro)
+{
+   return gSystem->Exec(Form("root -l -b -q -e 'gSystem->Exit(!gSystem->CompileMacro(\"%s\", \"k\"))'", macro.Data())) == 0;
+}
+
+// existing files matching pattern, wildcards in the last path component only
+inline std::vector<std::string> GlobFiles(const std::string& pattern)
+{
+   std::vector<std::string> files;
+   if (pattern.find('*') == std::string::npos) {
+      if (!gSystem->AccessPathName(pattern.c_str())) files.push_back(pattern);
+      return files;
+   }
+   const size_t slash = pattern.rfind('/');
+   const std::string dir  = slash == std::string::npos ? "." : pattern.substr(0, slash);
+   const std::string base = slash == std::string::npos ? pattern : pattern.substr(slash + 1);
+   const TRegexp re(base.c_str(), kTRUE);
+   void* d = gSystem->OpenDirectory(dir.c_str());
+   if (!d) return files;
+   while (const char* e = gSystem->GetDirEntry(d)) {
+      const TString name = e;
+      Ssiz_t len = 0;
+      if (name == "." || name == ".." || name.Index(re, &len) != 0 || len != name.Length()) continue;
+      files.push_back(slash == std::string::npos ? e : dir + "/" + e);
+   }
+   gSystem->FreeDirectory(d);
+   std::sort(files.begin(), files.end());
+   return files;
+}
+
+#endif
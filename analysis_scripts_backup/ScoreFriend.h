@@ -0,0 +1,148 @@
+#ifndef SCOREFRIEND_H
+#define SCOREFRIEND_H
+
+//   BDT score friend trees.
+//
+//   In friend mode the application step writes, next to each input ntuple X.root,
+//   a file X_bdtf.root with a tree "bdt" holding only
+//     BDT/F, BDTG/F : the scores (kNoScore for entries the application skips)
+//     srcEntry/L    : the entry number in X.root
+//   with one row per input entry and basket clusters at the same entries as the input.
+//
+//   OpenScored("..._cutopt_bdtr.root") returns a chain on the full _bdtr file if it
+//   exists, otherwise on "..._cutopt.root" with the friend attached and an entry list
+//   dropping the skipped entries, so the macros see the same events and columns. A
+//   friend written for another file, or with another number of entries than its
+//   source, is refused: OpenScored then returns 0.
+
+#include <iostream>
+#include <vector>
+
+#include "TChain.h"
+#include "TDirectory.h"
+#include "TEntryList.h"
+#include "TFile.h"
+#include "TNamed.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+const Float_t     kNoScore         = -99.;
+const char* const kScoreFriendTree = "bdt";
+
+inline TString ScoreFriendFileName(const char* src)
+{
+   TString f = src;
+   if (f.EndsWith(".root")) f.Remove(f.Length()-5);
+   return f + "_bdtf.root";
+}
+
+class ScoreFriendWriter {
+
+public:
+
+   ScoreFriendWriter(const char* srcfile, const char* treename = "tree")
+      : fBdt(kNoScore), fBdtg(kNoScore), fEntry(0), fNext(0)
+   {
+      // cluster boundaries of the source tree
+      TFile* src = TFile::Open(srcfile);
+      TTree* srcTree = src ? (TTree*)src->Get(treename) : 0;
+      if (srcTree) {
+         TTree::TClusterIterator it = srcTree->GetClusterIterator(0);
+         while (it() < srcTree->GetEntries()) fClusterEnds.push_back(it.GetNextEntry());
+      } else {
+         std::cout << "ScoreFriendWriter: cannot read " << treename << " from " << srcfile << std::endl;
+      }
+      delete src;
+
+      fFile = new TFile(ScoreFriendFileName(srcfile), "RECREATE");
+      fTree = new TTree(kScoreFriendTree, "BDT scores");
+      fTree->SetAutoFlush(0);
+      fTree->Branch("BDT",      &fBdt,   "BDT/F");
+      fTree->Branch("BDTG",     &fBdtg,  "BDTG/F");
+      fTree->Branch("srcEntry", &fEntry, "srcEntry/L");
+      TNamed("source", srcfile).Write();
+   }
+
+   // must be called once per source entry, in order
+   void Fill(Long64_t entry, Float_t bdt = kNoScore, Float_t bdtg = kNoScore)
+   {
+      fEntry = entry;
+      fBdt   = bdt;
+      fBdtg  = bdtg;
+      fTree->Fill();
+      if (fNext < fClusterEnds.size() && entry + 1 == fClusterEnds[fNext]) {
+         fTree->FlushBaskets();
+         ++fNext;
+      }
+   }
+
+   TFile* GetFile() const { return fFile; }
+
+   void Close()
+   {
+      fFile->cd();
+      fTree->Write();
+      std::cout << "--- Created friend file: \"" << fFile->GetName() << "\" (" << fTree->GetEntries() << " entries)" << std::endl;
+      fFile->Close();
+      delete fFile;
+   }
+
+private:
+
+   TFile*   fFile;
+   TTree*   fTree;
+   Float_t  fBdt, fBdtg;
+   Long64_t fEntry;
+   std::vector<Long64_t> fClusterEnds;
+   size_t   fNext;
+};
+
+inline TChain* OpenScored(const char* file, const char* treename = "tree")
+{
+   TChain* ch = new TChain(treename);
+   TString f = file;
+
+   if (gSystem->AccessPathName(f) && f.EndsWith("_bdtr.root")) {
+      TString src = TString(f(0, f.Length()-10)) + ".root";
+      TString fr  = ScoreFriendFileName(src);
+      if (!gSystem->AccessPathName(src) && !gSystem->AccessPathName(fr)) {
+         ch->Add(src);
+         TChain* frch = new TChain(kScoreFriendTree);
+         frch->Add(fr);
+
+         // the rows of the friend are the entries of the source it was written for
+         TString source;
+         if (TFile* ff = TFile::Open(fr)) {
+            if (TNamed* n = (TNamed*)ff->Get("source")) source = n->GetTitle();
+            delete ff;
+         }
+         if (TString(gSystem->BaseName(source)) != gSystem->BaseName(src)) {
+            std::cout << "OpenScored: " << fr << " was written for \"" << source << "\", not " << src << std::endl;
+            delete frch; delete ch;
+            return 0;
+         }
+         if (frch->GetEntries() != ch->GetEntries()) {
+            std::cout << "OpenScored: " << fr << " has " << frch->GetEntries() << " entries, "
+                      << src << " has " << ch->GetEntries() << std::endl;
+            delete frch; delete ch;
+            return 0;
+         }
+         ch->AddFriend(frch);
+
+         // drop the entries the application did not score, as in the _bdtr files
+         static int nList = 0;
+         TString elname = Form("scored_%d", nList++);
+         ch->Draw(">>" + elname, Form("BDT>%f", kNoScore), "entrylist");
+         ch->SetEntryList((TEntryList*)gDirectory->Get(elname));
+
+         std::cout << "OpenScored: reading " << src << " with friend " << fr << std::endl;
+         return ch;
+      }
+   }
+
+   ch->Add(file);
+   return ch;
+}
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef SELECTIONINDEX_H
+#define SELECTIONINDEX_H
+
+//   Precomputed selection bits for the named analysis cuts.
+//
+//   Each cut is defined once, by name, in AnalysisCuts(). Attach(chain) makes sure
+//   every file X.root of the chain has an up-to-date X_selidx.root with a tree
+//   "selidx" holding one UInt_t "selBits" per entry (bit k set if cut k passes), and
+//   adds it as a friend. All()/Any() then return the combination of cuts as a bitwise
+//   test on selBits, usable anywhere a TCut or a selection string is accepted:
+//
+//     SelectionIndex& cuts = AnalysisCuts();
+//     cuts.Attach(ch);
+//     ch->Draw("Bmass", cuts.All({"raretrig", "resrej1", "f2p"}) && "BDT>0.2");
+//
+//   All cuts are evaluated in one pass per file. An index is rebuilt when the cut
+//   definitions differ from the ones it was built with, or when the input file (or
+//   its BDT score friend, see ScoreFriend.h) was rewritten.
+
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TChain.h"
+#include "TCut.h"
+#include "TFile.h"
+#include "TNamed.h"
+#include "TObjArray.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeFormula.h"
+
+#include "RootFileId.h"
+#include "ScoreFriend.h"
+
+class SelectionIndex {
+
+public:
+
+   SelectionIndex(const char* tag = "selidx") : fTag(tag) {}
+
+   // Returns the bit of the cut, -1 if it could not be added.
+   int Define(const char* name, const char* expr)
+   {
+      for (size_t k = 0; k < fNames.size(); ++k) {
+         if (fNames[k] == name) { fExprs[k] = expr; return k; }
+      }
+      if (fNames.size() == 32) {
+         std::cout << "SelectionIndex: no bit left for cut " << name << std::endl;
+         return -1;
+      }
+      fNames.push_back(name);
+      fExprs.push_back(expr);
+      return fNames.size() - 1;
+   }
+
+   // selBits mask of the named cuts; 0 (and a message) if one is not defined
+   UInt_t Mask(std::initializer_list<const char*> names) const
+   {
+      UInt_t mask = 0;
+      for (const char* n : names) {
+         int k = Bit(n);
+         if (k < 0) { std::cout << "SelectionIndex: unknown cut " << n << std::endl; return 0; }
+         mask |= 1u << k;
+      }
+      return mask;
+   }
+
+   // all of the named cuts pass
+   TCut All(std::initializer_list<const char*> names) const
+   {
+      UInt_t m = Mask(names);
+      return m ? TCut(Form("(selBits&%u)==%u", m, m)) : TCut("0");
+   }
+
+   // at least one of the named cuts passes
+   TCut Any(std::initializer_list<const char*> names) const
+   {
+      UInt_t m = Mask(names);
+      return m ? TCut(Form("(selBits&%u)!=0", m)) : TCut("0");
+   }
+
+   // the same selection as All(), as a plain formula (for trees without an index)
+   TCut Expr(std::initializer_list<const char*> names) const
+   {
+      TCut c;
+      for (const char* n : names) {
+         int k = Bit(n);
+         if (k < 0) { std::cout << "SelectionIndex: unknown cut " << n << std::endl; return TCut("0"); }
+         c = c && TCut(Form("(%s)", fExprs[k].Data()));
+      }
+      return c;
+   }
+
+   TString IndexFileName(const char* src) const
+   {
+      TString f = src;
+      if (f.EndsWith(".root")) f.Remove(f.Length()-5);
+      return f + "_" + fTag + ".root";
+   }
+
+   // Builds the missing or stale indices of the files of ch and adds them as a
+   // friend. Returns false if there is no chain or an index could not be written.
+   bool Attach(TChain* ch)
+   {
+      if (!ch) return false;
+      if (TTree* old = ch->GetFriend(fTag)) ch->RemoveFriend(old);
+
+      TChain* idx = new TChain(fTag);
+      const bool scored = ch->GetFriend(kScoreFriendTree) != 0;
+      TObjArray* files = ch->GetListOfFiles();
+      for (int i = 0; i < files->GetEntriesFast(); ++i) {
+         const char* src = files->At(i)->GetTitle();
+         const TString out = IndexFileName(src);
+         const TString fr  = scored ? ScoreFriendFileName(src) : TString();
+         const TString id  = SourceId(src, fr);
+         if (!IsCurrent(out, id)) {
+            if (!Build(src, ch->GetName(), fr, out, id)) { delete idx; return false; }
+         }
+         idx->Add(out);
+      }
+      ch->AddFriend(idx);
+      return true;
+   }
+
+private:
+
+   int Bit(const char* name) const
+   {
+      for (size_t k = 0; k < fNames.size(); ++k) if (fNames[k] == name) return k;
+      return -1;
+   }
+
+   TString Definitions() const
+   {
+      TString d;
+      for (size_t k = 0; k < fNames.size(); ++k) d += Form("%zu %s : %s\n", k, fNames[k].Data(), fExprs[k].Data());
+      return d;
+   }
+
+   static TString SourceId(const char* src, const TString& scoreFriend)
+   {
+      TString id = RootFileId(src);
+      if (scoreFriend.Length() && !gSystem->AccessPathName(scoreFriend)) id += " + " + RootFileId(scoreFriend);
+      return id;
+   }
+
+   bool IsCurrent(const char* idxfile, const TString& id) const
+   {
+      if (gSystem->AccessPathName(idxfile)) return false;
+      TFile f(idxfile);
+      TNamed* src  = (TNamed*)f.Get("sourceId");
+      TNamed* cuts = (TNamed*)f.Get("cuts");
+      const bool ok = src && cuts && f.Get(fTag) && id == src->GetTitle() && Definitions() == cuts->GetTitle();
+      if (!ok) std::cout << "SelectionIndex: " << idxfile << " is out of date" << std::endl;
+      return ok;
+   }
+
+   bool Build(const char* src, const char* treename, const TString& scoreFriend, const char* out, const TString& id) const
+   {
+      TFile* in = TFile::Open(src);
+      TTree* tree = in ? (TTree*)in->Get(treename) : 0;
+      if (!tree) {
+         std::cout << "SelectionIndex: no tree " << treename << " in " << src << std::endl;
+         delete in;
+         return false;
+      }
+      if (scoreFriend.Length() && !gSystem->AccessPathName(scoreFriend)) tree->AddFriend(kScoreFriendTree, scoreFriend);
+
+      std::vector<TTreeFormula*> form(fNames.size(), 0);
+      for (size_t k = 0; k < fNames.size(); ++k) {
+         form[k] = new TTreeFormula(fNames[k], fExprs[k], tree);
+         if (form[k]->GetNdim() == 0) {
+            std::cout << "SelectionIndex: cut " << fNames[k] << " cannot be evaluated on " << src
+                      << ", its bit is 0" << std::endl;
+            delete form[k];
+            form[k] = 0;
+         }
+      }
+
+      TFile f(out, "RECREATE");
+      if (f.IsZombie()) { delete in; return false; }
+      TTree* bits = new TTree(fTag, "selection bits");
+      UInt_t selBits;
+      bits->Branch("selBits", &selBits, "selBits/i");
+
+      const Long64_t n = tree->GetEntries();
+      for (Long64_t i = 0; i < n; ++i) {
+         if (tree->LoadTree(i) < 0) break;
+         selBits = 0;
+         for (size_t k = 0; k < form.size(); ++k) {
+            if (!form[k]) continue;
+            form[k]->GetNdata();
+            if (form[k]->EvalInstance() != 0) selBits |= 1u << k;
+         }
+         bits->Fill();
+      }
+      for (TTreeFormula* t : form) delete t;
+
+      f.cd();
+      bits->Write();
+      TNamed("source", src).Write();
+      TNamed("sourceId", id.Data()).Write();
+      TNamed("cuts", Definitions().Data()).Write();
+      std::cout << "--- Created selection index: \"" << out << "\" (" << bits->GetEntries() << " entries, "
+                << fNames.size() << " cuts)" << std::endl;
+      f.Close();
+      delete in;
+      return true;
+   }
+
+   TString fTag;
+   std::vector<TString> fNames;
+   std::vector<TString> fExprs;
+};
+
+// The shared analysis cuts. Changing an expression here rebuilds the indices.
+inline SelectionIndex& AnalysisCuts()
+{
+   static SelectionIndex cuts = [] {
+      SelectionIndex c;
+      c.Define("trig",     "((JpsiTriggers==1) && dr0<0.1 && dr1<0.1 && mtrkqual==1 && ptrkqual==1)");
+      c.Define("raretrig", "((JpsiTriggers==1 || PsiPTriggers==1 || LMNTTriggers==1) && dr0<0.1 && dr1<0.1 && mtrkqual==1 && ptrkqual==1)");
+      c.Define("resrej1",  "Q2<11||Q2>8");
+      c.Define("resrej2",  "Q2<8 || Q2>11");
+      c.Define("resrej3",  "Q2<12.5 || Q2>15.0");
+      c.Define("f2p",      "(Phimass>1.525-2.5*0.079 && Phimass<1.525+2.5*0.079)");
+      c.Define("b1",       "(Bmass>5.366-2.5*0.03505 && Bmass<5.366+2.5*0.03505)");
+      c.Define("b2",       "(Bmass>5.6 && Bmass<5.6+5*0.03505)");
+      c.Define("b2open",   "(Bmass>5.6)");
+      c.Define("bdt",      "BDT>0.01");
+      return c;
+   }();
+   return cuts;
+}
+
+#endif
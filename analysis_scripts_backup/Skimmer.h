@@ -0,0 +1,81 @@
+#ifndef SKIMMER_H
+#define SKIMMER_H
+
+//   Streaming, multithreaded skim of a TChain.
+//
+//   The selection is compiled once and evaluated once per entry; the input and
+//   passing counts, the progress report and the output snapshot all come from the
+//   same event loop. Entry ranges (clusters) of all files are processed on parallel
+//   workers and written to one merged output file, so the entry order of the output
+//   is not that of the input. BDT/BDTG from a score friend (ScoreFriend.h) are
+//   written as ordinary branches.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Compression.h"
+#include "TChain.h"
+#include "TObjArray.h"
+#include "ROOT/RDataFrame.hxx"
+
+// branches: columns to keep (all input branches if empty)
+inline Long64_t SkimChain(TChain* in, const char* outfile, const char* selection,
+                          std::vector<std::string> branches = {}, int nThreads = 0,
+                          const char* treename = "tree")
+{
+   ROOT::EnableImplicitMT(nThreads);
+
+   if (branches.empty()) {
+      TObjArray* lb = in->GetListOfBranches();
+      for (int i = 0; lb && i < lb->GetEntriesFast(); ++i) branches.push_back(lb->At(i)->GetName());
+      if (in->GetListOfFriends() && in->GetListOfFriends()->GetSize()) {
+         for (const char* s : { "BDT", "BDTG" })
+            if (in->GetBranch(s) && !(lb && lb->FindObject(s))) branches.push_back(s);
+      }
+   }
+
+   ROOT::RDataFrame df(*in);
+   auto nAll = df.Count();
+   auto sel  = df.Filter(selection, "selection");
+   auto nSel = sel.Count();
+
+   // read speed matters more than file size for the skims, which are read many times
+   ROOT::RDF::RSnapshotOptions opts;
+   opts.fLazy = true;
+   opts.fCompressionAlgorithm = ROOT::kLZ4;
+   opts.fCompressionLevel = 4;
+   opts.fAutoFlush = -30000000;
+   auto snap = sel.Snapshot(treename, outfile, branches, opts);
+
+   // progress from the same loop: every worker reports each kReport entries it processed
+   const ULong64_t kReport = 100000;
+   const Long64_t nTotal = in->GetEntries();
+   std::atomic<ULong64_t> nDone(0);
+   std::mutex printLock;
+   const auto start = std::chrono::steady_clock::now();
+   nAll.OnPartialResultSlot(kReport, [&](unsigned int, ULong64_t&) {
+      const ULong64_t done = (nDone += kReport);
+      const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::lock_guard<std::mutex> lock(printLock);
+      std::cout << "--- " << done << " / " << nTotal << " entries ("
+                << int(100.*done/std::max<Long64_t>(nTotal, 1)) << " %), "
+                << Long64_t(done/std::max(secs, 1e-9)) << " events/s" << std::endl;
+   });
+
+   ROOT::RDF::RunGraphs({nAll, nSel, snap});
+
+   const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   std::cout << "# of events in original tuple = " << *nAll << std::endl;
+   std::cout << "# of events in original tuple after cuts = " << *nSel << std::endl;
+   std::cout << "--- skim written to " << outfile << " in " << secs << " s ("
+             << Long64_t(*nAll/std::max(secs, 1e-9)) << " events/s)" << std::endl;
+
+   return *nSel;
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef TMVAINPUTS_H
+#define TMVAINPUTS_H
+
+//   Training inputs of the BDT/BDTG classifiers, shared by TMVAClassification.C and
+//   TMVAGridSearch.C. A variable with an expression is booked as "name:=expr", so
+//   the weight files, and with them the application macros, are unchanged.
+
+#include <vector>
+
+#include "Rtypes.h"
+
+struct TMVAInput {
+   const char* name;
+   const char* expr;   // 0: the branch "name"
+};
+
+const std::vector<TMVAInput> kTMVAVariables = {
+   { "maxkpt",        "TMath::Max(Kmpt, Kppt)" },
+   { "maxktrk",       "TMath::Max(KmtrkMinIP/KmtrkMinIPE, KptrkMinIP/KptrkMinIPE)" },
+   { "maxmu",         "TMath::Max(MumMinIP/MumMinIPE, MupMinIP/MupMinIPE)" },
+   { "Blxysig",       0 },
+   { "Bvtxcl",        0 },
+// { "maxkmtrkdca",   "TMath::Max(Kmtrkdcasigbs, Kptrkdcasigbs)" },
+   { "Bcosalphabs2d", 0 },
+   { "Bsdcasigbs",    0 },
+   { "maxktriso",     "TMath::Max(kmtrkIso, kptrkIso)" },
+};
+
+const std::vector<const char*> kTMVASpectators = { "Bmass", "Mumumass" };
+
+const char* const kTMVASignalFile     = "mccutsf.root";
+const char* const kTMVABackgroundFile = "datacutsf_r.root";
+
+// global event weights per tree
+const Double_t kTMVASignalWeight     = 35.9/2788.4;
+const Double_t kTMVABackgroundWeight = 1.0;
+
+const char* const kTMVASignalCut     = "Blxysig>0 && Blxysig<9999 && Bsdcasigbs>0 && Bsdcasigbs<9999 && TMath::Max(MumMinIP/MumMinIPE, MupMinIP/MupMinIPE)>0 && TMath::Max(KmtrkMinIP/KmtrkMinIPE, KptrkMinIP/KptrkMinIPE)>0 ";
+const char* const kTMVABackgroundCut = "Blxysig>0 && Blxysig<9999 && Bsdcasigbs>0 && Bsdcasigbs<9999   && TMath::Max(MumMinIP/MumMinIPE, MupMinIP/MupMinIPE)>0 && TMath::Max(KmtrkMinIP/KmtrkMinIPE, KptrkMinIP/KptrkMinIPE)>0 ";
+
+#endif